@@ -4,6 +4,8 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 #include <pthread.h>
 #include <time.h>
 
@@ -14,6 +16,9 @@ typedef int bool;
 
 #define NUM_ROOMS_USED 7
 
+//inotify events watched on each rooms directory
+#define ROOM_FILE_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE)
+
 struct room {
     char name[8];
     int numOutboundConnections;
@@ -27,9 +32,45 @@ struct node {
     struct room* visitedRoom;
 };
 
+//World snapshot struct - A loaded set of rooms shared by every session playing it.
+//The snapshot is freed when the last reference to it is released.
+struct world {
+    struct room* rooms;
+    int refCount;
+};
+
+//Phase timing struct - Totals for one instrumented phase, reported at exit when stats are enabled.
+//Wall time is from CLOCK_MONOTONIC and CPU time is the process CPU time spent during the phase,
+//so it includes work on other threads such as the timeKeeper thread during the time command.
+struct phaseStat {
+    char* name;
+    long count;
+    long long wallNs;
+    long long cpuNs;
+    long long maxWallNs;
+};
+
+//Start times for a phase being measured.
+struct statStamp {
+    struct timespec wall;
+    struct timespec cpu;
+};
+
+enum statPhase {
+    STAT_FIND_NEWEST_DIR,
+    STAT_READ_ROOMS,
+    STAT_MOVE,
+    STAT_TIME_COMMAND,
+    NUM_STAT_PHASES
+};
+
 //Function prototypes
 char* FindNewestDir();
 struct room* ReadRooms(char* dirName, int numRooms);
+struct room* TryReadRooms(char* dirName, int numRooms);
+bool TryReadRoomName(char* filePath, struct room* room);
+bool TryReadRoomDetails(char* filePath, struct room* room, struct room roomArray[], int numRooms);
+struct room* FindRoomByName(char* name, struct room roomArray[], int numRooms);
 struct room* GetRoomByName(char* name, struct room roomArray[]);
 struct room* GetStartRoom(struct room roomArray[]);
 void PrintPossibleConnections(struct room* room);
@@ -40,11 +81,64 @@ void CleanUpLinkedList(struct node* node);
 void PrintLinkedList(struct node* node);
 void* WriteCurrentTime();
 void ReadFirstLine(char* fileName);
+void PlayGame(struct room* allRooms);
+bool PlayAgain();
+struct world* NewWorld(struct room* rooms);
+struct world* AcquireWorld();
+void ReleaseWorld(struct world* world);
+void SwapWorld(struct world* newWorld);
+void ReloadWorld(char* dirName, bool roomFilesChanged, char* loadedDirName, struct timespec* loadedDirTime);
+bool HasRoomFileEvent(char* eventBuffer, ssize_t numRead, int dirWatch);
+void* WatchWorlds(void* mainDirName);
+void CloseWatch(void* watchFd);
+void StatsStart(struct statStamp* stamp);
+void StatsStop(int phase, struct statStamp* stamp);
+void PrintStats();
 
 pthread_t timeKeeper;
 pthread_mutex_t timeKeeperLock = PTHREAD_MUTEX_INITIALIZER;
 
-int main() {
+pthread_t worldWatcher;
+pthread_mutex_t worldLock = PTHREAD_MUTEX_INITIALIZER;
+struct world* currentWorld = NULL;
+
+//Stats are enabled with --stats or by setting SOUTHEJA_STATS. Phases may be timed from the watcher thread.
+bool statsEnabled = false;
+pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+struct phaseStat phaseStats[NUM_STAT_PHASES] = {
+    { .name = "find_newest_dir" },
+    { .name = "read_rooms" },
+    { .name = "move" },
+    { .name = "time_command" }
+};
+
+int main(int argc, char* argv[]) {
+    //With --watch the process keeps running, offering new sessions and picking up new worlds as they are built.
+    //With --stats phase timings are printed to stderr at exit.
+    bool watchWorlds = false;
+    char* statsEnv = getenv("SOUTHEJA_STATS");
+    if (statsEnv != NULL && statsEnv[0] != '\0' && strcmp(statsEnv, "0") != 0) {
+        statsEnabled = true;
+    }
+
+    int i;
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--watch") == 0) {
+            watchWorlds = true;
+        }
+        else if (strcmp(argv[i], "--stats") == 0) {
+            statsEnabled = true;
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--watch] [--stats]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    if (statsEnabled == true) {
+        atexit(PrintStats);
+    }
+
     //Lock mutex to main
     pthread_mutex_lock(&timeKeeperLock);
 
@@ -53,9 +147,40 @@ int main() {
 
     //Get the name of the newest created rooms directory and read all the data from the files contained within.
     char* newestDirName = FindNewestDir();
-    struct room* allRooms = ReadRooms(newestDirName, NUM_ROOMS_USED);
+    currentWorld = NewWorld(ReadRooms(newestDirName, NUM_ROOMS_USED));
+
+    //Create the world watcher thread so new worlds are loaded off the game thread.
+    if (watchWorlds == true) {
+        pthread_create(&worldWatcher, NULL, WatchWorlds, newestDirName);
+    }
+
+    //Each session plays on the world snapshot current when it started, even if a newer world is swapped in.
+    do {
+        struct world* sessionWorld = AcquireWorld();
+        PlayGame(sessionWorld->rooms);
+        ReleaseWorld(sessionWorld);
+    } while (watchWorlds == true && PlayAgain() == true);
+
+    //Stop the watcher thread and drop the last reference to the current world.
+    if (watchWorlds == true) {
+        pthread_cancel(worldWatcher);
+        pthread_join(worldWatcher, NULL);
+    }
+    ReleaseWorld(currentWorld);
+    pthread_mutex_destroy(&worldLock);
     free(newestDirName);
 
+    //Cancel the thread if it was never run. Allow it to run to completion so no memory is lost.
+    pthread_cancel(timeKeeper);
+    pthread_mutex_unlock(&timeKeeperLock);
+    pthread_join(timeKeeper, NULL);
+    pthread_mutex_destroy(&timeKeeperLock);
+
+    return 0;
+}
+
+//Function: Play one game on the given rooms until the END_ROOM is found.
+void PlayGame(struct room* allRooms) {
     //Retrieve the struct for the starting room.
     struct room* currentRoom;
     currentRoom = GetStartRoom(allRooms);
@@ -97,21 +222,31 @@ int main() {
 
     //Free allocated linkedList memory
     CleanUpLinkedList(head);
-    free(allRooms);
+}
 
-    //Cancel the thread if it was never run. Allow it to run to completion so no memory is lost.
-    pthread_cancel(timeKeeper);
-    pthread_mutex_unlock(&timeKeeperLock);
-    pthread_join(timeKeeper, NULL);
-    pthread_mutex_destroy(&timeKeeperLock);
+//Function: Ask the player whether to start a new session. Returns true on 'y'.
+bool PlayAgain() {
+    size_t len = 0;
+    char* enteredLine = NULL;
+    bool playAgain = false;
 
-    return 0;
+    printf("\nPLAY AGAIN? (y/n) >");
+    if (getline(&enteredLine, &len, stdin) != -1 && enteredLine[0] == 'y') {
+        playAgain = true;
+    }
+    printf("\n");
+
+    free(enteredLine);
+    return playAgain;
 }
 
 
 //Function: Find the name of the newest created directory in the calling directory.
 char* FindNewestDir() {
-    int newestDirTime = -1;
+    struct statStamp stamp;
+    StatsStart(&stamp);
+
+    struct timespec newestDirTime = { -1, 0 };
     char targetDirPrefix[32] = "southeja.rooms.";
     char* newestDirName = malloc(sizeof(char) * 256);
     memset(newestDirName, '\0', sizeof(newestDirName));
@@ -132,9 +267,10 @@ char* FindNewestDir() {
                 //Get the directory stats
                 stat(fileInDir->d_name, &dirAttributes);
 
-                //Set the newest time and name to the greater time
-                if ((int)dirAttributes.st_mtime > newestDirTime) {
-                    newestDirTime = (int)dirAttributes.st_mtime;
+                //Set the newest time and name to the greater time, comparing nanoseconds so directories built in the same second are ordered
+                if (dirAttributes.st_mtim.tv_sec > newestDirTime.tv_sec
+                        || (dirAttributes.st_mtim.tv_sec == newestDirTime.tv_sec && dirAttributes.st_mtim.tv_nsec > newestDirTime.tv_nsec)) {
+                    newestDirTime = dirAttributes.st_mtim;
                     memset(newestDirName, '\0', sizeof(newestDirName));
                     strcpy(newestDirName, fileInDir->d_name);
                 }
@@ -144,12 +280,17 @@ char* FindNewestDir() {
 
     closedir(dirToCheck);
 
+    StatsStop(STAT_FIND_NEWEST_DIR, &stamp);
+
     return newestDirName;
 }
 
 //Function: Read room data into a list of structs and return the list. 
 //Takes a directory name and number of room files to read as input.
 struct room* ReadRooms(char* dirName, int numRooms) {
+    struct statStamp stamp;
+    StatsStart(&stamp);
+
     //Allocate a list of room* with memory for the number of rooms.
     struct room* rooms = malloc(sizeof(struct room) * numRooms);
 
@@ -271,9 +412,174 @@ struct room* ReadRooms(char* dirName, int numRooms) {
     free(line);
     closedir(dirToOpen);
 
+    StatsStop(STAT_READ_ROOMS, &stamp);
+
     return rooms;
 }
 
+//Function: Read room data like ReadRooms, but return NULL instead of exiting if the data is incomplete or invalid.
+//Used for reloads so a half-written rooms directory cannot end a running game.
+struct room* TryReadRooms(char* dirName, int numRooms) {
+    char fileNames[numRooms][256];
+    char filePath[512];
+    int numFiles = 0;
+
+    DIR* dirToOpen;
+    struct dirent* fileInDir;
+
+    //Collect the room file names once so both passes read the files in the same order.
+    dirToOpen = opendir(dirName);
+    if (dirToOpen == NULL) {
+        return NULL;
+    }
+
+    while ((fileInDir = readdir(dirToOpen)) != NULL) {
+        //Skip files starting with '.'
+        if (fileInDir->d_name[0] != '.') {
+            if (numFiles == numRooms) {
+                closedir(dirToOpen);
+                return NULL;
+            }
+
+            snprintf(fileNames[numFiles], sizeof(fileNames[numFiles]), "%s", fileInDir->d_name);
+            numFiles++;
+        }
+    }
+    closedir(dirToOpen);
+
+    if (numFiles != numRooms) {
+        return NULL;
+    }
+
+    struct room* rooms = malloc(sizeof(struct room) * numRooms);
+
+    //Read all the room names so connections can be resolved, rejecting duplicate names.
+    int i;
+    for (i = 0; i < numRooms; i++) {
+        snprintf(filePath, sizeof(filePath), "%s/%s", dirName, fileNames[i]);
+
+        if (TryReadRoomName(filePath, &rooms[i]) == false || FindRoomByName(rooms[i].name, rooms, i) != NULL) {
+            free(rooms);
+            return NULL;
+        }
+    }
+
+    //Read the connections and room type of each room, and check there is a start and end room.
+    bool hasStartRoom = false;
+    bool hasEndRoom = false;
+    for (i = 0; i < numRooms; i++) {
+        snprintf(filePath, sizeof(filePath), "%s/%s", dirName, fileNames[i]);
+
+        if (TryReadRoomDetails(filePath, &rooms[i], rooms, numRooms) == false) {
+            free(rooms);
+            return NULL;
+        }
+
+        if (strcmp(rooms[i].roomType, "START_ROOM") == 0) {
+            hasStartRoom = true;
+        }
+        else if (strcmp(rooms[i].roomType, "END_ROOM") == 0) {
+            hasEndRoom = true;
+        }
+    }
+
+    if (hasStartRoom == false || hasEndRoom == false) {
+        free(rooms);
+        return NULL;
+    }
+
+    return rooms;
+}
+
+//Function: Read the room name from the first line of a room file. Returns false if it is missing or unreadable.
+bool TryReadRoomName(char* filePath, struct room* room) {
+    FILE* fileToRead = fopen(filePath, "r");
+    if (fileToRead == NULL) {
+        return false;
+    }
+
+    size_t len = 0;
+    char* line = NULL;
+    bool found = false;
+
+    if (getline(&line, &len, fileToRead) != -1 && sscanf(line, "ROOM NAME: %7s", room->name) == 1) {
+        found = true;
+    }
+
+    free(line);
+    fclose(fileToRead);
+
+    return found;
+}
+
+//Function: Read the connections and room type of a room file. Returns false if a connection
+//cannot be resolved, there are too many connections, or the room type line has not been written.
+bool TryReadRoomDetails(char* filePath, struct room* room, struct room roomArray[], int numRooms) {
+    FILE* fileToRead = fopen(filePath, "r");
+    if (fileToRead == NULL) {
+        return false;
+    }
+
+    size_t len = 0;
+    char* line = NULL;
+    char connection[8];
+    bool valid = true;
+
+    room->numOutboundConnections = 0;
+    memset(room->roomType, '\0', sizeof(room->roomType));
+
+    //Skip the room name line, which has already been read
+    if (getline(&line, &len, fileToRead) == -1) {
+        valid = false;
+    }
+
+    //Read every line until the room type line, which must be the last line in the file
+    while (valid == true && getline(&line, &len, fileToRead) != -1) {
+        if (room->roomType[0] != '\0') {
+            valid = false;
+        }
+        else if (strncmp(line, "CONNECTION", 10) == 0) {
+            struct room* connectedRoom = NULL;
+            if (sscanf(line, "%*s %*s %7s", connection) == 1) {
+                connectedRoom = FindRoomByName(connection, roomArray, numRooms);
+            }
+
+            if (connectedRoom == NULL || room->numOutboundConnections == 6) {
+                valid = false;
+            }
+            else {
+                room->outboundConnections[room->numOutboundConnections] = connectedRoom;
+                room->numOutboundConnections += 1;
+            }
+        }
+        else if (sscanf(line, "%10s", room->roomType) != 1) {
+            valid = false;
+        }
+    }
+
+    if (strcmp(room->roomType, "START_ROOM") != 0 && strcmp(room->roomType, "MID_ROOM") != 0
+            && strcmp(room->roomType, "END_ROOM") != 0) {
+        valid = false;
+    }
+
+    free(line);
+    fclose(fileToRead);
+
+    return valid;
+}
+
+//Function: Get a room struct pointer by the rooms name, or NULL if no room in the first numRooms has that name.
+struct room* FindRoomByName(char* name, struct room roomArray[], int numRooms) {
+    int i;
+    for (i = 0; i < numRooms; i++) {
+        if (strcmp(name, roomArray[i].name) == 0) {
+            return &roomArray[i];
+        }
+    }
+
+    return NULL;
+}
+
 //Function: get a room struct pointer by the rooms name. Takes a name string and room list as input.
 struct room* GetRoomByName(char* name, struct room roomArray[]) {
     int i;
@@ -331,6 +637,7 @@ struct room* MoveRooms(struct room* room, struct room roomArray[]) {
     size_t userInput;
     size_t len = 0;
     char* enteredLine = NULL;
+    struct statStamp moveStamp;
 
     //Loop until the user enters a valid room name or asks for the time
     do {
@@ -346,10 +653,16 @@ struct room* MoveRooms(struct room* room, struct room roomArray[]) {
         }
         printf("WHERE TO? >");
         userInput = getline(&enteredLine, &len, stdin);
+
+        //Move latency runs from the accepted input arriving to the room being resolved, not the wait on the player
+        StatsStart(&moveStamp);
         sscanf(enteredLine, "%s", enteredLine); //remove newline character or remove space and all chars after
         
         //If user calls time allow the timeKeeper thread to run
         if (strcmp(enteredLine, "time") == 0) {
+            struct statStamp stamp;
+            StatsStart(&stamp);
+
             pthread_mutex_unlock(&timeKeeperLock);
             pthread_join(timeKeeper, NULL);
             pthread_mutex_lock(&timeKeeperLock);
@@ -357,6 +670,8 @@ struct room* MoveRooms(struct room* room, struct room roomArray[]) {
             pthread_create(&timeKeeper, NULL, WriteCurrentTime, NULL);
 
             ReadFirstLine("currentTime.txt");
+
+            StatsStop(STAT_TIME_COMMAND, &stamp);
         }
 
     } while (IsValidInput(enteredLine, validRooms, room->numOutboundConnections) != true);
@@ -370,7 +685,10 @@ struct room* MoveRooms(struct room* room, struct room roomArray[]) {
 
     free(enteredLine);
 
-    return GetRoomByName(storeLine, roomArray);
+    struct room* nextRoom = GetRoomByName(storeLine, roomArray);
+    StatsStop(STAT_MOVE, &moveStamp);
+
+    return nextRoom;
 
 }
 
@@ -465,4 +783,235 @@ void ReadFirstLine(char* fileName) {
 
     free(line);
     fclose(fileToRead);
+}
+
+//Function: Wrap a list of rooms in a world snapshot. The caller owns the single initial reference.
+struct world* NewWorld(struct room* rooms) {
+    struct world* world = malloc(sizeof(struct world));
+    world->rooms = rooms;
+    world->refCount = 1;
+
+    return world;
+}
+
+//Function: Take a reference to the current world so it stays valid for the length of a session.
+struct world* AcquireWorld() {
+    pthread_mutex_lock(&worldLock);
+    struct world* world = currentWorld;
+    world->refCount++;
+    pthread_mutex_unlock(&worldLock);
+
+    return world;
+}
+
+//Function: Drop a reference to a world, freeing it once no session or the current pointer uses it.
+void ReleaseWorld(struct world* world) {
+    pthread_mutex_lock(&worldLock);
+    int remaining = --world->refCount;
+    pthread_mutex_unlock(&worldLock);
+
+    if (remaining == 0) {
+        free(world->rooms);
+        free(world);
+    }
+}
+
+//Function: Publish a fully built world for new sessions. Sessions already running keep their snapshot.
+void SwapWorld(struct world* newWorld) {
+    pthread_mutex_lock(&worldLock);
+    struct world* oldWorld = currentWorld;
+    currentWorld = newWorld;
+    pthread_mutex_unlock(&worldLock);
+
+    ReleaseWorld(oldWorld);
+}
+
+//Function: Load a rooms directory and swap it in as the current world, if all of its room files have been written.
+//Skipped when the directory is the loaded world and neither its mtime nor its room files have changed.
+//On success the loaded directory name and mtime are updated.
+void ReloadWorld(char* dirName, bool roomFilesChanged, char* loadedDirName, struct timespec* loadedDirTime) {
+    struct stat dirAttributes;
+    if (stat(dirName, &dirAttributes) != 0) {
+        return;
+    }
+
+    if (roomFilesChanged == false && strcmp(dirName, loadedDirName) == 0
+            && dirAttributes.st_mtim.tv_sec == loadedDirTime->tv_sec
+            && dirAttributes.st_mtim.tv_nsec == loadedDirTime->tv_nsec) {
+        return;
+    }
+
+    //A directory still being written is skipped and the current world kept; the next closed file retries the reload.
+    struct statStamp stamp;
+    StatsStart(&stamp);
+    struct room* rooms = TryReadRooms(dirName, NUM_ROOMS_USED);
+
+    //Only a world that was actually loaded counts as a read_rooms phase
+    if (rooms != NULL) {
+        StatsStop(STAT_READ_ROOMS, &stamp);
+        SwapWorld(NewWorld(rooms));
+
+        strcpy(loadedDirName, dirName);
+        *loadedDirTime = dirAttributes.st_mtim;
+    }
+}
+
+//Function: Returns true if a batch of inotify events has a room file written, moved in or deleted in the given watch.
+bool HasRoomFileEvent(char* eventBuffer, ssize_t numRead, int dirWatch) {
+    char* position;
+    for (position = eventBuffer; position < eventBuffer + numRead; ) {
+        struct inotify_event* event = (struct inotify_event*)position;
+
+        if (event->wd == dirWatch && (event->mask & ROOM_FILE_EVENTS)) {
+            return true;
+        }
+
+        position += sizeof(struct inotify_event) + event->len;
+    }
+
+    return false;
+}
+
+//Function: Watch the calling directory for new or modified rooms directories and reload the world when they change.
+//Takes the name of the rooms directory main loaded, which stays valid until the thread is joined.
+void* WatchWorlds(void* mainDirName) {
+    char targetDirPrefix[32] = "southeja.rooms.";
+    char eventBuffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t numRead;
+
+    //Name and mtime of the rooms directory the current world was loaded from
+    char loadedDirName[256];
+    struct timespec loadedDirTime = { -1, 0 };
+    struct stat dirAttributes;
+
+    memset(loadedDirName, '\0', sizeof(loadedDirName));
+    strcpy(loadedDirName, mainDirName);
+    if (stat(loadedDirName, &dirAttributes) == 0) {
+        loadedDirTime = dirAttributes.st_mtim;
+    }
+
+    //Only allow the thread to be canceled while it is waiting on read()
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+    int watchFd = inotify_init();
+    if (watchFd == -1) {
+        fprintf(stderr, "unable to watch for new rooms\n");
+        return NULL;
+    }
+
+    //Close the watch descriptor whether the loop ends or the thread is canceled
+    pthread_cleanup_push(CloseWatch, &watchFd);
+
+    //Watch the calling directory for new rooms directories
+    int cwdWatch = inotify_add_watch(watchFd, ".", IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+
+    //Watch the loaded rooms directory for modified room files
+    if (loadedDirName[0] != '\0') {
+        inotify_add_watch(watchFd, loadedDirName, ROOM_FILE_EVENTS);
+    }
+
+    //Pick up any world built between main loading its world and the watches being added
+    char* newestDirName = FindNewestDir();
+    if (newestDirName[0] != '\0') {
+        ReloadWorld(newestDirName, false, loadedDirName, &loadedDirTime);
+    }
+    free(newestDirName);
+
+    //Loop on events until the thread is canceled.
+    while (true) {
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        numRead = read(watchFd, eventBuffer, sizeof(eventBuffer));
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        if (numRead <= 0) {
+            break;
+        }
+
+        //Add a watch to each new rooms directory so the room files written into it are seen.
+        //Other files created in the calling directory, such as currentTime.txt, are ignored.
+        bool roomsChanged = false;
+        char* position;
+        for (position = eventBuffer; position < eventBuffer + numRead; ) {
+            struct inotify_event* event = (struct inotify_event*)position;
+
+            if (event->wd != cwdWatch) {
+                roomsChanged = true;
+            }
+            else if ((event->mask & IN_ISDIR) && event->len > 0 && strstr(event->name, targetDirPrefix) != NULL) {
+                inotify_add_watch(watchFd, event->name, ROOM_FILE_EVENTS);
+                roomsChanged = true;
+            }
+
+            position += sizeof(struct inotify_event) + event->len;
+        }
+
+        if (roomsChanged == false) {
+            continue;
+        }
+
+        //Adding a watch that already exists returns its descriptor, so the newest directory's events can be found.
+        newestDirName = FindNewestDir();
+        if (newestDirName[0] != '\0') {
+            int newestWatch = inotify_add_watch(watchFd, newestDirName, ROOM_FILE_EVENTS);
+            ReloadWorld(newestDirName, HasRoomFileEvent(eventBuffer, numRead, newestWatch), loadedDirName, &loadedDirTime);
+        }
+        free(newestDirName);
+    }
+
+    pthread_cleanup_pop(1);
+
+    return NULL;
+}
+
+//Function: Close the inotify descriptor used by the world watcher thread.
+void CloseWatch(void* watchFd) {
+    close(*(int*)watchFd);
+}
+
+//Function: Record the start of a phase. Does nothing when stats are disabled.
+void StatsStart(struct statStamp* stamp) {
+    if (statsEnabled == false) {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stamp->wall);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stamp->cpu);
+}
+
+//Function: Add the wall and CPU time since StatsStart to the totals for a phase.
+void StatsStop(int phase, struct statStamp* stamp) {
+    if (statsEnabled == false) {
+        return;
+    }
+
+    struct timespec wall;
+    struct timespec cpu;
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+
+    long long wallNs = (wall.tv_sec - stamp->wall.tv_sec) * 1000000000LL + (wall.tv_nsec - stamp->wall.tv_nsec);
+    long long cpuNs = (cpu.tv_sec - stamp->cpu.tv_sec) * 1000000000LL + (cpu.tv_nsec - stamp->cpu.tv_nsec);
+
+    pthread_mutex_lock(&statsLock);
+    phaseStats[phase].count++;
+    phaseStats[phase].wallNs += wallNs;
+    phaseStats[phase].cpuNs += cpuNs;
+    if (wallNs > phaseStats[phase].maxWallNs) {
+        phaseStats[phase].maxWallNs = wallNs;
+    }
+    pthread_mutex_unlock(&statsLock);
+}
+
+//Function: Print one line per phase to stderr, as space separated key=value pairs.
+void PrintStats() {
+    pthread_mutex_lock(&statsLock);
+
+    int i;
+    for (i = 0; i < NUM_STAT_PHASES; i++) {
+        fprintf(stderr, "stats program=adventure phase=%s count=%ld wall_us=%lld process_cpu_us=%lld max_wall_us=%lld\n",
+            phaseStats[i].name, phaseStats[i].count, phaseStats[i].wallNs / 1000,
+            phaseStats[i].cpuNs / 1000, phaseStats[i].maxWallNs / 1000);
+    }
+
+    pthread_mutex_unlock(&statsLock);
 }
\ No newline at end of file
@@ -22,6 +22,40 @@ struct room {
 #define NUM_ROOMS 10
 #define NUM_ROOMS_USED 7
 
+//Phase timing struct - Totals for one instrumented phase, reported at exit when stats are enabled.
+//Wall time is from CLOCK_MONOTONIC and CPU time is the process CPU time spent during the phase.
+struct phaseStat {
+    char* name;
+    long count;
+    long long wallNs;
+    long long cpuNs;
+    long long maxWallNs;
+};
+
+//Start times for a phase being measured.
+struct statStamp {
+    struct timespec wall;
+    struct timespec cpu;
+};
+
+enum statPhase {
+    STAT_BUILD_GRAPH,
+    STAT_GENERATE_ROOM_FILE,
+    NUM_STAT_PHASES
+};
+
+//Stats are enabled with --stats or by setting SOUTHEJA_STATS.
+bool statsEnabled = false;
+struct phaseStat phaseStats[NUM_STAT_PHASES] = {
+    { .name = "build_graph" },
+    { .name = "generate_room_file" }
+};
+
+//Counters for AddRandomConnection: connections added and random rooms rejected while picking A and B.
+long numConnectionsAdded = 0;
+long numRoomARetries = 0;
+long numRoomBRetries = 0;
+
 //Function prototypes
 bool IsGraphFull(struct room ray[]);
 void AddRandomConnection(struct room roomArray[]);
@@ -31,17 +65,33 @@ bool ConnectionAlreadyExists(struct room* x, struct room* y);
 void ConnectRoom(struct room* x, struct room* y);
 bool IsSameRoom(struct room* x, struct room* y);
 void GenerateRoomFile(struct room* someRoom, char* dirName);
+void StatsStart(struct statStamp* stamp);
+void StatsStop(int phase, struct statStamp* stamp);
+void PrintStats();
 
-int main(int argc) {
+int main(int argc, char* argv[]) {
     //Seed rand
     srand(time(NULL));
 
-    //If southeja.buildrooms is called with arguments, exit.
-    if (argc > 1) {
-    	fprintf(stderr, "Error: Function takes no arguments!\n");
+    char* statsEnv = getenv("SOUTHEJA_STATS");
+    if (statsEnv != NULL && statsEnv[0] != '\0' && strcmp(statsEnv, "0") != 0) {
+        statsEnabled = true;
+    }
+
+    //If southeja.buildrooms is called with arguments other than --stats, exit.
+    if (argc == 2 && strcmp(argv[1], "--stats") == 0) {
+        statsEnabled = true;
+    }
+    else if (argc > 1) {
+    	fprintf(stderr, "Error: Function takes no arguments other than --stats!\n");
 	exit(1);
     }
 
+    //Print phase timings to stderr at exit.
+    if (statsEnabled == true) {
+        atexit(PrintStats);
+    }
+
     //Retrieve the process id
     int pid = getpid();
     char mypid[6];
@@ -125,13 +175,18 @@ int main(int argc) {
     }
 
     // Create all connections in graph
+    struct statStamp stamp;
+    StatsStart(&stamp);
     while (IsGraphFull(chosenRooms) == false) {
         AddRandomConnection(chosenRooms);
     }
+    StatsStop(STAT_BUILD_GRAPH, &stamp);
 
     //Generate the file for each room
     for (i = 0; i < NUM_ROOMS_USED; i++) {
+        StatsStart(&stamp);
     	GenerateRoomFile(&chosenRooms[i], dirName);
+        StatsStop(STAT_GENERATE_ROOM_FILE, &stamp);
     }
 
     return 0;
@@ -160,18 +215,25 @@ void AddRandomConnection(struct room roomArray[]) {
 
         if (CanAddConnectionFrom(A) == true)
         break;
+
+        numRoomARetries++;
     }
 
     //Get a 2nd room which can make a connection, isn't the same as A, and doesn't already connect to A.
-    do
+    while(true)
     {
         B = GetRandomRoom(roomArray);
+
+        if (CanAddConnectionFrom(B) == true && IsSameRoom(A, B) == false && ConnectionAlreadyExists(A, B) == false)
+        break;
+
+        numRoomBRetries++;
     }
-    while(CanAddConnectionFrom(B) == false || IsSameRoom(A, B) == true || ConnectionAlreadyExists(A, B) == true);
 
     //Connect A to B and B to A
     ConnectRoom(A, B);
     ConnectRoom(B, A);
+    numConnectionsAdded++;
 }
 
 //Function: Returns a random Room, does NOT validate if connection can be added.
@@ -228,4 +290,50 @@ void GenerateRoomFile(struct room* someRoom, char* dirName) {
     //Print room type to file
 	fprintf(newFile, "%s\n", someRoom->roomType);
 	fclose(newFile);
+}
+
+//Function: Record the start of a phase. Does nothing when stats are disabled.
+void StatsStart(struct statStamp* stamp) {
+    if (statsEnabled == false) {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stamp->wall);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stamp->cpu);
+}
+
+//Function: Add the wall and CPU time since StatsStart to the totals for a phase.
+void StatsStop(int phase, struct statStamp* stamp) {
+    if (statsEnabled == false) {
+        return;
+    }
+
+    struct timespec wall;
+    struct timespec cpu;
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+
+    long long wallNs = (wall.tv_sec - stamp->wall.tv_sec) * 1000000000LL + (wall.tv_nsec - stamp->wall.tv_nsec);
+    long long cpuNs = (cpu.tv_sec - stamp->cpu.tv_sec) * 1000000000LL + (cpu.tv_nsec - stamp->cpu.tv_nsec);
+
+    phaseStats[phase].count++;
+    phaseStats[phase].wallNs += wallNs;
+    phaseStats[phase].cpuNs += cpuNs;
+    if (wallNs > phaseStats[phase].maxWallNs) {
+        phaseStats[phase].maxWallNs = wallNs;
+    }
+}
+
+//Function: Print one line per phase and counter to stderr, as space separated key=value pairs.
+void PrintStats() {
+    int i;
+    for (i = 0; i < NUM_STAT_PHASES; i++) {
+        fprintf(stderr, "stats program=buildrooms phase=%s count=%ld wall_us=%lld process_cpu_us=%lld max_wall_us=%lld\n",
+            phaseStats[i].name, phaseStats[i].count, phaseStats[i].wallNs / 1000,
+            phaseStats[i].cpuNs / 1000, phaseStats[i].maxWallNs / 1000);
+    }
+
+    fprintf(stderr, "stats program=buildrooms counter=connections_added value=%ld\n", numConnectionsAdded);
+    fprintf(stderr, "stats program=buildrooms counter=room_a_retries value=%ld\n", numRoomARetries);
+    fprintf(stderr, "stats program=buildrooms counter=room_b_retries value=%ld\n", numRoomBRetries);
 }
\ No newline at end of file